@@ -1,5 +1,14 @@
 #include "hello_pybind11/oop.h"
 
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
 namespace py = pybind11;
 // to be able to use "arg"_a shorthand
 using namespace pybind11::literals;
@@ -173,6 +182,151 @@ void internal_types(py::module &m){
 }
 
 
+// Structured numpy dtypes
+// def_readwrite only gives access to one instance at a time (and bird.attr even returns a copy of the nested struct).
+// For large populations: store POD records contiguously and register them with PYBIND11_NUMPY_DTYPE
+// -> numpy sees the store as a structured array, viewed without copy and modifiable in place.
+// dtype fields must be trivially copyable: std::string -> fixed width char array ('S16' dtype, longer names are rejected)
+// and the enum is stored as its integer value (validated when read back, the numpy view lets users write anything).
+// Bird::Attributes is intentionally flattened: age is a top level field, recs['age'] rather than recs['attr']['age'].
+constexpr size_t RECORD_NAME_SIZE = 16;
+
+struct BirdRecord {
+    char name[RECORD_NAME_SIZE];
+    int32_t kind;
+    float age;
+};
+
+struct OverlordRecord {
+    char name[RECORD_NAME_SIZE];
+    int32_t age;
+};
+
+// Longer names are rejected rather than truncated: truncation loses data and can split a multi-byte UTF-8 character.
+// Same for embedded null characters, read_name would stop at the first one.
+void write_name(char (&dst)[RECORD_NAME_SIZE], const std::string &src){
+    if (src.size() > RECORD_NAME_SIZE)
+        throw py::value_error("name '" + src + "' is longer than " + std::to_string(RECORD_NAME_SIZE) + " bytes");
+    if (src.find('\0') != std::string::npos)
+        throw py::value_error("name contains a null character");
+    std::memset(dst, 0, RECORD_NAME_SIZE);
+    std::memcpy(dst, src.data(), src.size());
+}
+
+// numpy 'S' strings are not necessarily null terminated
+std::string read_name(const char (&src)[RECORD_NAME_SIZE]){
+    return std::string(src, std::find(src, src + RECORD_NAME_SIZE, '\0'));
+}
+
+BirdRecord to_record(const Bird &b){
+    BirdRecord r{};
+    write_name(r.name, b.name);
+    r.kind = static_cast<int32_t>(b.type);
+    r.age = b.attr.age;
+    return r;
+}
+
+Bird from_record(const BirdRecord &r){
+    // casting an out of range value to an enum without fixed underlying type is undefined behaviour
+    if (r.kind != Bird::Kind::Crow && r.kind != Bird::Kind::Goose)
+        throw py::value_error("invalid bird kind " + std::to_string(r.kind));
+    Bird b(read_name(r.name), static_cast<Bird::Kind>(r.kind));
+    b.attr.age = r.age;
+    return b;
+}
+
+OverlordRecord to_record(const Overlord &o){
+    OverlordRecord r{};
+    write_name(r.name, o.name);
+    r.age = o.age;
+    return r;
+}
+
+Overlord from_record(const OverlordRecord &r){
+    return Overlord(read_name(r.name), r.age);
+}
+
+// Fixed size once constructed: the vector is never reallocated so numpy views on it stay valid
+template <typename Object, typename Record>
+class RecordStore {
+public:
+    RecordStore(size_t size) : records(size) { }  // value initialized -> zeros
+    RecordStore(const std::vector<Object> &objects) {
+        records.reserve(objects.size());
+        for (const auto &o: objects) records.push_back(to_record(o));
+    }
+
+    size_t size() const { return records.size(); }
+    Record *data() { return records.data(); }
+    const std::vector<Record> &getRecords() const { return records; }
+
+    void set(py::ssize_t i, const Object &o) { records[index(i)] = to_record(o); }
+    Object get(py::ssize_t i) const { return from_record(records[index(i)]); }
+
+private:
+    // python style indexing
+    size_t index(py::ssize_t i) const {
+        if (i < 0) i += size();
+        if (i < 0 || i >= (py::ssize_t) size()) throw py::index_error("record index out of range");
+        return i;
+    }
+
+    std::vector<Record> records;
+};
+
+using BirdStore = RecordStore<Bird, BirdRecord>;
+using OverlordStore = RecordStore<Overlord, OverlordRecord>;
+
+// Native kernels working directly on the records, no python object per record
+// mean_age returns NaN if no bird has the given kind, same as numpy mean of an empty selection
+float birds_mean_age(const BirdStore &store, Bird::Kind kind){
+    double sum = 0;
+    size_t n = 0;
+    for (const auto &r: store.getRecords()) {
+        if (r.kind == kind) {
+            sum += r.age;
+            n++;
+        }
+    }
+    if (n == 0) return std::numeric_limits<float>::quiet_NaN();
+    return static_cast<float>(sum / static_cast<double>(n));
+}
+
+void birds_grow_older(BirdStore &store, float years){
+    for (size_t i = 0; i < store.size(); i++) store.data()[i].age += years;
+}
+
+template <typename Store, typename Object, typename Record>
+py::class_<Store> bind_record_store(py::module &m, const char *name){
+    // built from RECORD_NAME_SIZE so the docstring follows the constant
+    static const std::string name_doc = "Names longer than " + std::to_string(RECORD_NAME_SIZE)
+                                        + " bytes or containing null characters raise ValueError";
+    return py::class_<Store>(m, name)
+        .def(py::init<size_t>(), "size"_a)
+        .def(py::init<const std::vector<Object> &>(), "objects"_a,
+             name_doc.c_str())  // list -> std::vector conversion from pybind11/stl.h (copy)
+        .def("__len__", &Store::size)
+        .def("__getitem__", &Store::get)
+        .def("__setitem__", &Store::set, name_doc.c_str())
+        // self passed as base of the array: the store cannot be garbage collected while a view is alive
+        .def_property_readonly("records", [](py::object self) {
+            auto &store = self.cast<Store &>();
+            return py::array_t<Record>(store.size(), store.data(), self);
+        }, "Zero-copy structured array view on the records");
+}
+
+void structured_dtypes(py::module &m){
+    // Registers the numpy dtype of the structs, field names have to match the struct members
+    PYBIND11_NUMPY_DTYPE(BirdRecord, name, kind, age);
+    PYBIND11_NUMPY_DTYPE(OverlordRecord, name, age);
+
+    bind_record_store<BirdStore, Bird, BirdRecord>(m, "BirdStore")
+        .def("mean_age", &birds_mean_age, "Mean age of the birds of a given kind", "kind"_a)
+        .def("grow_older", &birds_grow_older, "Add years to the age of every bird, in place", "years"_a);
+    bind_record_store<OverlordStore, Overlord, OverlordRecord>(m, "OverlordStore");
+}
+
+
 // Custom Constructors 
 // 1: private constructors, happens quite rarely :
 // acccording to https://www.geeksforgeeks.org/can-constructor-private-cpp/
@@ -245,6 +399,7 @@ void def_examples_oop(py::module &m) {
     checking_inheritance_polymorphism(m);
     overloading_functions(m);
     internal_types(m);
+    structured_dtypes(m);
     custom_constructors(m);
 
     m.def("get_pet_couple", &get_pet_couple);
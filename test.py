@@ -82,6 +82,35 @@ print(b.Kind.__members__)  # enumeration types are exposed with "__"
 print(b.name)
 print(b.attr)
 
+# Structured dtypes: contiguous records, viewed from numpy without copy
+birds = hpb.BirdStore([hpb.Bird("Lucy", hpb.Bird.Goose), hpb.Bird("Russell", hpb.Bird.Crow), hpb.Bird("Ganders", hpb.Bird.Goose)])
+recs = birds.records
+print(recs.dtype)  # [('name', 'S16'), ('kind', '<i4'), ('age', '<f4')]
+print(recs)
+recs['age'][recs['kind'] == int(hpb.Bird.Goose)] = 3.0  # vectorized in place update
+print(birds[0].name, birds[0].attr.age)  # modified through the view
+birds.grow_older(1.0)  # native kernel
+print(recs['age'])
+print(birds.mean_age(hpb.Bird.Goose))
+try:
+    birds[0] = hpb.Bird("Großer Graugans Vogel", hpb.Bird.Goose)  # names are limited to 16 bytes
+except ValueError as e:
+    print(e)
+try:
+    birds[0] = hpb.Bird("ab\0cd", hpb.Bird.Goose)  # would be cut at the null character when read back
+except ValueError as e:
+    print(e)
+recs['kind'][1] = 7  # the view lets us write anything...
+try:
+    birds[1]  # ...but invalid kinds are rejected when read back
+except ValueError as e:
+    print(e)
+recs['kind'][1] = int(hpb.Bird.Crow)
+crows = hpb.BirdStore([hpb.Bird("Russell", hpb.Bird.Crow)])
+print(crows.mean_age(hpb.Bird.Goose))  # nan, like numpy mean of an empty selection
+overlords = hpb.OverlordStore([hpb.Overlord(), hpb.Overlord('Sauron', 42)])
+print(overlords.records['age'].mean())
+
 # Custom constructors
 epri = hpb.ExampleCCprivate(12)
 epub = hpb.ExampleCCpublic(34)